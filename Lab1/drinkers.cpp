@@ -0,0 +1,183 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <vector>
+#include <unistd.h>
+#include "mpi.h"
+#include "resource_manager.h"
+#include "transport.h"
+
+#define THINK_STEPS     5
+#define THINK_TIME      20000
+#define DRINK_TIME      50000
+
+/*
+ * Simulacija pijucih filozofa (raspodijeljeni upravitelj sredstvima) nad grafom sukoba
+ *
+ * Pokretanje: mpirun -np N drinkers [-b] <graf|ring> [trajanje_s] [all]
+ *         ili drinkers -t N [-b] <graf|ring> [trajanje_s] [all]
+ *  - -t N : N filozofa kao dretve jednog procesa (poruke kroz lock-free sanducice umjesto MPI-a)
+ *  - -b : bez razmisljanja i pijenja, mjeri se samo cijena protokola i prijenosa poruka
+ *  - graf : datoteka s grafom sukoba (vidi readConflictGraph), ring : prsten kao u philosophers.cpp
+ *  - trajanje_s : koliko sekundi filozofi zapocinju nove sesije (zadano 10)
+ *  - all : svaka sesija trazi sva sredstva (klasicni filozofi za stolom), inace slucajni podskup
+ *
+ * Na kraju se ispisuje ukupan broj sesija i propusnost (sesija/s) pa se
+ * "ring 10 all" moze izravno usporediti s proizvoljnim grafom i podskupovima sredstava,
+ * a isti graf s -t i bez njega usporeduje dretve i MPI.
+ */
+
+long drinker(Transport &net, const std::vector<int> &neighbors, double &elapsed);
+void think(ResourceManager &manager, unsigned &seed);
+void drink(unsigned &seed);
+std::vector<int> chooseResources(ResourceManager &manager, unsigned &seed);
+double now();
+
+double duration = 10.0;
+bool all = false, benchmark = false;
+std::atomic<double> startTime(0);      // pocetak mjerenja, zajednicki svim dretvama procesa
+
+int main(int argc, char** argv){
+    int numThreads = 0, arg = 1;
+    if(arg < argc && strcmp(argv[arg], "-t") == 0){
+        numThreads = arg + 1 < argc ? atoi(argv[arg + 1]) : 0;
+        if(numThreads <= 0){
+            printf("Uporaba: %s [-t N] [-b] <graf|ring> [trajanje_s] [all]\n", argv[0]);
+            return 1;
+        }
+        arg += 2;
+    }
+    if(arg < argc && strcmp(argv[arg], "-b") == 0){
+        benchmark = true;
+        arg++;
+    }
+
+    int myRank = 0, numProcs = numThreads;
+    if(numThreads == 0){
+        MPI_Init(&argc, &argv);
+        MPI_Comm_rank(MPI_COMM_WORLD, &myRank);
+        MPI_Comm_size(MPI_COMM_WORLD, &numProcs);
+    }
+
+    bool valid = arg < argc && numProcs > 0;
+    std::vector<std::vector<int>> adjacency;
+    if(valid){
+        duration = arg + 1 < argc ? atof(argv[arg + 1]) : 10.0;
+        all = arg + 2 < argc && strcmp(argv[arg + 2], "all") == 0;
+
+        if(strcmp(argv[arg], "ring") == 0){
+            ringConflictGraph(numProcs, adjacency);
+        } else if(!readConflictGraph(argv[arg], numProcs, adjacency)){
+            if(myRank == 0){
+                printf("Neispravan graf sukoba %s (ocekuje se %d vrhova)\n", argv[arg], numProcs);
+            }
+            valid = false;
+        }
+    } else if(myRank == 0){
+        printf("Uporaba: %s [-t N] [-b] <graf|ring> [trajanje_s] [all]\n", argv[0]);
+    }
+
+    if(!valid){
+        if(numThreads == 0){
+            MPI_Finalize();
+        }
+        return 1;
+    }
+
+    long totalSessions = 0;
+    double maxElapsed = 0;
+    if(numThreads == 0){
+        MpiTransport net;
+        double elapsed;
+        long sessions = drinker(net, adjacency[myRank], elapsed);
+        MPI_Reduce(&sessions, &totalSessions, 1, MPI_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+        MPI_Reduce(&elapsed, &maxElapsed, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+    } else {
+        ThreadNetwork network(numThreads);
+        std::vector<long> sessions(numThreads);
+        std::vector<double> elapsed(numThreads);
+        runThreads(numThreads, [&](int rank) {
+            ThreadTransport net(network, rank);
+            sessions[rank] = drinker(net, adjacency[rank], elapsed[rank]);
+        });
+        for(int i = 0; i < numThreads; i++){
+            totalSessions += sessions[i];
+            maxElapsed = elapsed[i] > maxElapsed ? elapsed[i] : maxElapsed;
+        }
+    }
+
+    if(myRank == 0){
+        printf("%s, filozofa: %d, sesija: %ld, vrijeme: %.2f s, propusnost: %.2f sesija/s\n",
+               numThreads ? "dretve" : "MPI", numProcs, totalSessions, maxElapsed, totalSessions / maxElapsed);
+    }
+
+    if(numThreads == 0){
+        MPI_Finalize();
+    }
+    return 0;
+}
+
+/*
+ * Zivot jednog filozofa - vraca broj odradenih sesija, a u elapsed trajanje do zavrsnog protokola
+ */
+long drinker(Transport &net, const std::vector<int> &neighbors, double &elapsed) {
+    unsigned seed = time(nullptr) + net.rank();
+    ResourceManager manager(net, neighbors);
+
+    net.barrier();
+    double start = 0;
+    startTime.compare_exchange_strong(start, now());    // Prvi filozof nakon barijere odreduje pocetak
+    start = startTime.load();
+
+    long sessions = 0;
+    while(now() - start < duration){
+        think(manager, seed);       // Filozof misli i istovremeno odgovara na zahtjeve drugih filozofa
+        manager.acquire(chooseResources(manager, seed));
+        drink(seed);                // Pij
+        manager.release();
+        sessions++;
+    }
+    manager.finish();
+
+    elapsed = now() - start;
+    return sessions;
+}
+
+void think(ResourceManager &manager, unsigned &seed) {
+    for(int i = 0; i < THINK_STEPS; i++){
+        if(!benchmark){
+            usleep(rand_r(&seed) % THINK_TIME + 1000);
+        }
+        manager.poll();         // Neblokirajuca obrada zahtjeva za vilicama i bocama
+    }
+}
+
+void drink(unsigned &seed) {
+    if(!benchmark){
+        usleep(rand_r(&seed) % DRINK_TIME + 1000);
+    }
+}
+
+/*
+ * Svako sredstvo (brid prema susjedu) trazi se s vjerojatnoscu 1/2, a barem jedno uvijek
+ */
+std::vector<int> chooseResources(ResourceManager &manager, unsigned &seed) {
+    std::vector<int> resources;
+    int n = manager.numResources();
+    for(int i = 0; i < n; i++){
+        if(all || rand_r(&seed) % 2){
+            resources.push_back(manager.neighbor(i));
+        }
+    }
+    if(resources.empty() && n > 0){
+        resources.push_back(manager.neighbor(rand_r(&seed) % n));
+    }
+    return resources;
+}
+
+double now() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
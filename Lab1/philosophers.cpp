@@ -1,10 +1,13 @@
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
 #include <unistd.h>
 #include "mpi.h"
+#include "transport.h"
 #define RIGHT    0
 #define LEFT     1
+#define MAX_INDENT   16
 
 /*
  * Struktura vilice
@@ -20,133 +23,167 @@ typedef struct {
     bool clean;
 } fork_;
 
-void printTabs(int rank);
-void think();
-void eat();
-void parseMessage(char forkId);
+void printState(int rank, const char *state);
 char othersFork(char forkId);
 
-int numProcs, myRank;
-fork_ myForks[2];
-
-int main(int argc, char** argv){
-    MPI_Init(&argc, &argv);
-    // Inicijalizacija filozofa
-    // indeks procesa
-    MPI_Comm_rank(MPI_COMM_WORLD, &myRank);
-    // ukupan broj procesa
-    MPI_Comm_size(MPI_COMM_WORLD, &numProcs);
-
-    srand(time(nullptr) + myRank);
-    MPI_Status mpiStatus;
-
-    // inicijalizacija desnog i lijevog susjeda
-    myForks[RIGHT].neighbor = (myRank + numProcs - 1) % numProcs;
-
-    myForks[LEFT].neighbor = (myRank + 1) % numProcs;
-
-    /*
-     * vilicu na pocetku ima filozof s manjim indeksom
-     * vilica je na pocetku prljava
-    */
-    for(auto &fork : myForks){
-        fork.haveIt = fork.neighbor > myRank;
-        fork.clean = false;
-        fork.request = 0;
+/*
+ * Filozof za okruglim stolom - poruke salje i prima preko Transport apstrakcije
+ * (MPI proces ili dretva s lock-free sanducicem)
+ * run - zivot filozofa (misli, trazi vilice, jede)
+ * think - filozof misli i istovremeno odgovara na zahtjeve drugih filozofa
+ * parseMessage - obrada zahtjeva za vilicom forkId
+ */
+class Philosopher {
+private:
+    Transport &net;
+    int numProcs, myRank;
+    unsigned seed;
+    fork_ myForks[2];
+
+public:
+    explicit Philosopher(Transport &net) : net(net) {
+        // indeks filozofa i ukupan broj filozofa
+        myRank = net.rank();
+        numProcs = net.size();
+        seed = time(nullptr) + myRank;
+
+        // inicijalizacija desnog i lijevog susjeda
+        myForks[RIGHT].neighbor = (myRank + numProcs - 1) % numProcs;
+
+        myForks[LEFT].neighbor = (myRank + 1) % numProcs;
+
+        /*
+         * vilicu na pocetku ima filozof s manjim indeksom
+         * vilica je na pocetku prljava
+        */
+        for(auto &fork : myForks){
+            fork.haveIt = fork.neighbor > myRank;
+            fork.clean = false;
+            fork.request = 0;
+        }
     }
 
+    void run() {
+        usleep(500000);
+        net.barrier();
+
+        while(true){
+            think();        // Filozof misli i istovremeno odgavara na zahtjeve drugih filozofa
+            // Filozof treba dvije vilice
+            while(!myForks[RIGHT].haveIt || !myForks[LEFT].haveIt)
+            {
+                int neededFork;
+                for(neededFork = 0; myForks[neededFork].haveIt; neededFork++);
+
+                char state[32];
+                snprintf(state, sizeof(state), "Trazim vilicu (%d)", myForks[neededFork].neighbor);
+                printState(myRank, state);
+
+                char forkToRequest = othersFork(neededFork);
+
+                net.send(forkToRequest, myForks[neededFork].neighbor, 0);     // Posalji zahtjev za vilicom
+
+                do {        // Cekaj da dobijes trazenu vilicu
+                    int forkId, source, tag;
+                    net.recv(forkId, source, tag);
+                    if(tag == 0){
+                        parseMessage(forkId);
+                    } else if (tag == 1){
+                        myForks[forkId].haveIt = true;
+                        myForks[forkId].clean = true;
+                    }
+
+                } while(!myForks[neededFork].haveIt);
+            }
+            eat();      // Jedi
 
-    usleep(500000);
-    MPI_Barrier(MPI_COMM_WORLD);
-
-    while(true){
-        think();        // Filozof misli i istovremeno odgavara na zahtjeve drugih filozofa
-        // Filozof treba dvije vilice
-        while(!myForks[RIGHT].haveIt || !myForks[LEFT].haveIt)
-        {
-            int neededFork;
-//            printf("Nemam vilicu[0] : %d", myForks[0].haveIt == false);
-            for(neededFork = 0; myForks[neededFork].haveIt; neededFork++);
-
-            printTabs(myRank);
-            printf("Trazim vilicu (%d)\n", myForks[neededFork].neighbor);
-
-            char forkToRequest = othersFork(neededFork);
-
-            MPI_Send(&forkToRequest, 1, MPI_CHAR, myForks[neededFork].neighbor, 0, MPI_COMM_WORLD);     // Posalji zahtjev za vilicom
+            myForks[0].clean = false;   // Vilice postaju prljave nakon jela
 
-            do {        // Cekaj da dobijes trazenu vilicu
-                char forkId;
-                MPI_Recv(&forkId, 1, MPI_CHAR, MPI_ANY_SOURCE, MPI_ANY_TAG, MPI_COMM_WORLD, &mpiStatus);
-                if(mpiStatus.MPI_TAG == 0){
-                    parseMessage(forkId);
-                } else if (mpiStatus.MPI_TAG == 1){
-                    myForks[forkId].haveIt = true;
-                    myForks[forkId].clean = true;
+            myForks[1].clean = false;
+            for(int i = 0; i < 2; i++){
+                if(myForks[i].request){
+                    char forkToSend = othersFork(i);                // Posalji vilicu ako postoji zahtjev za njom
+                    net.send(forkToSend, myForks[i].neighbor, 1);
+                    myForks[i].haveIt = false;
+                    myForks[i].request = 0;
                 }
-
-            } while(!myForks[neededFork].haveIt);
+            }
         }
-        eat();      // Jedi
-
-        myForks[0].clean = false;   // Vilice postaju prljave nakon jela
+    }
 
-        myForks[1].clean = false;
-        for(int i = 0; i < 2; i++){
-            if(myForks[i].request){
-                char forkToSend = othersFork(i);                // Posalji vilicu ako postoji zahtjev za njom
-                MPI_Send(&forkToSend, 1, MPI_CHAR, myForks[i].neighbor, 1, MPI_COMM_WORLD);
-                myForks[i].haveIt = false;
-                myForks[i].request = 0;
+private:
+    void think() {
+        int thinkingTime;
+        printState(myRank, "mislim");
+        for(int i = 0; i < 15; i++){
+            thinkingTime = rand_r(&seed) % 400000 + 10000;
+            usleep(thinkingTime);
+            // Neblokirajuca provjera postoji li poruka - zahtjev za vilicom
+            if(net.probe()){
+                int forkId, source, tag;
+                net.recv(forkId, source, tag);
+
+                parseMessage(forkId);
             }
         }
     }
 
-    MPI_Finalize();
-    return 0;
-}
+    void eat() {
+        int eatingTime;
+        eatingTime = rand_r(&seed) % 5000000 + 100000;
+        printState(myRank, "jedem");
+        usleep(eatingTime);     // spavaj
+    }
 
-void printTabs(int rank){
-    while(rank--){
-        printf("\t\t");
+    void parseMessage(int forkId) {
+        if(myForks[forkId].clean){
+            myForks[forkId].request = 1;        // Oznaci zahtjev za vilicom
+        } else {                                // Posalji vilicu
+            char forkToSend = othersFork(forkId);
+            net.send(forkToSend, myForks[forkId].neighbor, 1);
+            myForks[forkId].request = 0;
+            myForks[forkId].haveIt = false;
+        }
     }
-}
+};
 
-void think() {
-    int thinkingTime, flag;
-    printTabs(myRank);
-    printf("mislim\n");
-    for(int i = 0; i < 15; i++){
-        thinkingTime = rand() % 400000 + 10000;
-        usleep(thinkingTime);
-        // Neblokirajuca provjera postoji li poruka - zahtjev za vilicom
-        MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, MPI_COMM_WORLD, &flag, MPI_STATUS_IGNORE);
-        if(flag){
-            char forkId;
-            MPI_Recv(&forkId, 1, MPI_CHAR, MPI_ANY_SOURCE, MPI_ANY_TAG, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-
-            parseMessage(forkId);
+/*
+ * Pokretanje: mpirun -np N philosophers
+ *         ili philosophers -t N (N filozofa kao dretve jednog procesa, poruke kroz lock-free sanducice)
+ */
+int main(int argc, char** argv){
+    if(argc > 1 && strcmp(argv[1], "-t") == 0){
+        int numThreads = argc > 2 ? atoi(argv[2]) : 0;
+        if(numThreads <= 0){
+            printf("Uporaba: %s [-t N]\n", argv[0]);
+            return 1;
         }
+        ThreadNetwork network(numThreads);
+        runThreads(numThreads, [&](int rank) {
+            ThreadTransport net(network, rank);
+            Philosopher(net).run();
+        });
+        return 0;
     }
-}
 
-void eat() {
-    int eatingTime;
-    eatingTime = rand() % 5000000 + 100000;
-    printTabs(myRank);
-    printf("jedem\n");
-    usleep(eatingTime);     // spavaj
+    MPI_Init(&argc, &argv);
+    // Inicijalizacija filozofa
+    MpiTransport net;
+    Philosopher(net).run();
+
+    MPI_Finalize();
+    return 0;
 }
 
-void parseMessage(char forkId) {
-    if(myForks[forkId].clean){
-        myForks[forkId].request = 1;        // Oznaci zahtjev za vilicom
-    } else {                                // Posalji vilicu
-        char forkToSend = othersFork(forkId);
-        MPI_Send(&forkToSend, 1, MPI_CHAR, myForks[forkId].neighbor, 1, MPI_COMM_WORLD);
-        myForks[forkId].request = 0;
-        myForks[forkId].haveIt = false;
-    }
+/*
+ * Ispis stanja filozofa uvucen za rank (najvise MAX_INDENT) razina
+ * Cijeli redak ide jednim pozivom printf kako se ispisi dretvi ne bi mijesali
+ */
+void printState(int rank, const char *state){
+    static const char tabs[2 * MAX_INDENT + 1] = "\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t"
+                                                 "\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t";
+    int indent = rank < MAX_INDENT ? rank : MAX_INDENT;
+    printf("%.*s%d: %s\n", 2 * indent, tabs, rank, state);
 }
 
 char othersFork(char forkId) {
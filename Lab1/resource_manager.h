@@ -0,0 +1,310 @@
+#ifndef RESOURCE_MANAGER_H
+#define RESOURCE_MANAGER_H
+
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <vector>
+#include "transport.h"
+
+/*
+ * Ucitava graf sukoba iz datoteke path
+ * Format datoteke: u prvom retku broj vrhova n, zatim po jedan brid "u v" u svakom retku
+ * Svaki brid predstavlja jedno dijeljeno sredstvo (bocu) izmedu procesa u i v
+ * adjacency[i] - popis susjeda procesa i
+ * Vraca false ako datoteka ne postoji, nije ispravna (neispravan znak, nepotpun ili ponovljen brid) ili broj vrhova nije jednak numProcs
+ */
+inline bool readConflictGraph(const char *path, int numProcs, std::vector<std::vector<int>> &adjacency) {
+    FILE *file = fopen(path, "r");
+    if (file == nullptr) {
+        return false;
+    }
+
+    int n, u, v, read;
+    if (fscanf(file, "%d", &n) != 1 || n != numProcs) {
+        fclose(file);
+        return false;
+    }
+
+    adjacency.assign(n, std::vector<int>());
+    while ((read = fscanf(file, "%d %d", &u, &v)) == 2) {
+        if (u < 0 || u >= n || v < 0 || v >= n || u == v
+            || std::find(adjacency[u].begin(), adjacency[u].end(), v) != adjacency[u].end()) {
+            fclose(file);
+            return false;       // brid izvan grafa, petlja ili ponovljeni brid
+        }
+        adjacency[u].push_back(v);
+        adjacency[v].push_back(u);
+    }
+
+    fclose(file);
+    return read == EOF;         // citanje mora stati tek na kraju datoteke
+}
+
+/*
+ * Graf sukoba prstena - svaki proces dijeli sredstvo s (myRank +- 1) % numProcs
+ */
+inline void ringConflictGraph(int numProcs, std::vector<std::vector<int>> &adjacency) {
+    adjacency.assign(numProcs, std::vector<int>());
+    for (int i = 0; i < numProcs; i++) {
+        int next = (i + 1) % numProcs;
+        if (next == i || (numProcs == 2 && i == 1)) {
+            continue;       // s dva procesa postoji samo jedan brid
+        }
+        adjacency[i].push_back(next);
+        adjacency[next].push_back(i);
+    }
+}
+
+/*
+ * Struktura brida grafa sukoba (gledano iz perspektive jednog procesa)
+ *  - neighbor : id susjeda s kojim dijelim brid
+ *  - haveFork, clean : je li vilica kod mene i je li cista
+ *  - forkAsked : poslao sam zahtjev za vilicom i cekam je
+ *  - forkRequest : susjed je trazio vilicu, a ja sam odgodio slanje
+ *  - haveBottle, bottleAsked, bottleRequest : isto za bocu (dijeljeno sredstvo)
+ *  - need : trebam li bocu u trenutnoj sesiji
+ */
+typedef struct {
+    int neighbor;
+    bool haveFork;
+    bool clean;
+    bool forkAsked;
+    bool forkRequest;
+    bool haveBottle;
+    bool bottleAsked;
+    bool bottleRequest;
+    bool need;
+} edge_;
+
+/*
+ * Upravitelj sredstvima po Chandy-Misra algoritmu pijucih filozofa nad proizvoljnim grafom sukoba
+ * Na svakom bridu nalaze se vilica (cista/prljava, kao kod filozofa za stolom) i boca (sredstvo).
+ * Zedni proces trazi samo boce koje mu trebaju i postaje gladan; proces koji jede (drzi sve vilice)
+ * ima prednost za boce pa se izbjegava potpuni zastoj, a susjedi s disjunktnim bocama piju istovremeno.
+ *
+ * acquire - blokira dok ne dobije sve trazene boce (resources su id-evi susjeda)
+ * release - otpusta boce i salje odgodene boce susjedima
+ * poll - neblokirajuca obrada pristiglih poruka (poziva se dok proces misli)
+ * finish - zavrsni protokol; nakon njega nema vise poruka od ni prema susjedima
+ */
+class ResourceManager {
+private:
+    // oznake (tag) poruka izmedu susjeda
+    enum MessageTag {
+        FORK_REQUEST,
+        FORK,
+        BOTTLE_REQUEST,
+        BOTTLE,
+        DONE
+    };
+
+    Transport &net;
+    int myRank;
+    std::vector<edge_> edges;
+    std::map<int, int> edgeIndex;       // id susjeda -> indeks brida
+    bool hungry, eating, thirsty, drinking;
+    int doneCount;
+
+public:
+    ResourceManager(Transport &net, const std::vector<int> &neighbors) : net(net) {
+        myRank = net.rank();
+        hungry = eating = thirsty = drinking = false;
+        doneCount = 0;
+
+        /*
+         * vilicu i bocu na pocetku ima proces s manjim indeksom
+         * vilica je na pocetku prljava
+         */
+        for (int neighbor : neighbors) {
+            if (neighbor == myRank || edgeIndex.count(neighbor)) {
+                continue;       // ponovljeni brid bi razdvojio vilicu na dvije kopije
+            }
+            edge_ edge{};
+            edge.neighbor = neighbor;
+            edge.haveFork = edge.haveBottle = neighbor > myRank;
+            edgeIndex[neighbor] = (int) edges.size();
+            edges.push_back(edge);
+        }
+    }
+
+    int numResources() {
+        return (int) edges.size();
+    }
+
+    int neighbor(int i) {
+        return edges[i].neighbor;
+    }
+
+    void acquire(const std::vector<int> &resources) {
+        for (int resource : resources) {
+            edges[edgeIndex.at(resource)].need = true;
+        }
+
+        thirsty = true;
+        for (auto &edge : edges) {
+            if (edge.need && !edge.haveBottle && !edge.bottleAsked) {
+                send(BOTTLE_REQUEST, edge.neighbor);
+                edge.bottleAsked = true;
+            }
+        }
+
+        tryDrink();
+        if (thirsty && !hungry && !eating) {
+            becomeHungry();
+        }
+
+        while (!drinking) {
+            waitMessage();
+        }
+    }
+
+    void release() {
+        drinking = false;
+        for (auto &edge : edges) {
+            edge.need = false;
+            if (edge.bottleRequest) {           // Posalji bocu ako postoji zahtjev za njom
+                send(BOTTLE, edge.neighbor);
+                edge.haveBottle = false;
+                edge.bottleRequest = false;
+            }
+        }
+    }
+
+    void poll() {
+        while (net.probe()) {
+            waitMessage();
+        }
+    }
+
+    void finish() {
+        while (hungry || eating) {      // Zaostala glad iz zadnje sesije
+            waitMessage();
+        }
+        for (auto &edge : edges) {
+            send(DONE, edge.neighbor);
+        }
+        while (doneCount < (int) edges.size()) {
+            waitMessage();
+        }
+    }
+
+private:
+    void send(int tag, int dest) {
+        net.send(myRank, dest, tag);
+    }
+
+    void waitMessage() {
+        int value, source, tag;
+        net.recv(value, source, tag);
+        parseMessage(tag, source);
+    }
+
+    void parseMessage(int tag, int source) {
+        if (tag == DONE) {
+            doneCount++;
+            return;
+        }
+
+        edge_ &edge = edges[edgeIndex.at(source)];
+        switch (tag) {
+            case FORK_REQUEST:
+                if (edge.clean || eating) {
+                    edge.forkRequest = true;        // Oznaci zahtjev za vilicom
+                } else {                            // Posalji vilicu
+                    sendFork(edge);
+                }
+                break;
+            case FORK:
+                edge.haveFork = true;
+                edge.clean = true;
+                edge.forkAsked = false;
+                tryEat();
+                break;
+            case BOTTLE_REQUEST:
+                if (edge.need && (drinking || (thirsty && eating))) {
+                    edge.bottleRequest = true;      // Oznaci zahtjev za bocom
+                } else {                            // Posalji bocu
+                    send(BOTTLE, edge.neighbor);
+                    edge.haveBottle = false;
+                    if (thirsty && edge.need) {     // I dalje mi treba, zatrazi je natrag
+                        send(BOTTLE_REQUEST, edge.neighbor);
+                        edge.bottleAsked = true;
+                    }
+                }
+                break;
+            case BOTTLE:
+                edge.haveBottle = true;
+                edge.bottleAsked = false;
+                tryDrink();
+                break;
+            default:
+                break;
+        }
+    }
+
+    void sendFork(edge_ &edge) {
+        send(FORK, edge.neighbor);
+        edge.haveFork = false;
+        edge.forkRequest = false;
+        if (hungry) {                               // I dalje sam gladan, zatrazi je natrag
+            send(FORK_REQUEST, edge.neighbor);
+            edge.forkAsked = true;
+        }
+    }
+
+    void becomeHungry() {
+        hungry = true;
+        for (auto &edge : edges) {
+            if (!edge.haveFork && !edge.forkAsked) {
+                send(FORK_REQUEST, edge.neighbor);
+                edge.forkAsked = true;
+            }
+        }
+        tryEat();
+    }
+
+    void tryEat() {
+        if (!hungry) {
+            return;
+        }
+        for (auto &edge : edges) {
+            if (!edge.haveFork) {
+                return;
+            }
+        }
+        hungry = false;
+        eating = true;
+        if (!thirsty) {             // Vec sam pio, nema potrebe drzati vilice
+            stopEating();
+        }
+    }
+
+    void stopEating() {
+        eating = false;
+        for (auto &edge : edges) {
+            edge.clean = false;     // Vilice postaju prljave nakon jela
+            if (edge.forkRequest) {
+                sendFork(edge);
+            }
+        }
+    }
+
+    void tryDrink() {
+        if (!thirsty) {
+            return;
+        }
+        for (auto &edge : edges) {
+            if (edge.need && !edge.haveBottle) {
+                return;
+            }
+        }
+        thirsty = false;
+        drinking = true;
+        if (eating) {
+            stopEating();
+        }
+    }
+};
+
+#endif
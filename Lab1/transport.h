@@ -0,0 +1,273 @@
+#ifndef TRANSPORT_H
+#define TRANSPORT_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <vector>
+#include <pthread.h>
+#include "mpi.h"
+
+/*
+ * Apstrakcija razmjene poruka izmedu filozofa (poruka je jedan int i oznaka tag)
+ * rank, size - indeks filozofa i ukupan broj filozofa
+ * send - salje poruku filozofu dest
+ * recv - blokirajuce prima sljedecu poruku od bilo kojeg filozofa
+ * probe - neblokirajuca provjera postoji li poruka
+ * barrier - ceka da svi filozofi dodu do barijere
+ */
+class Transport {
+public:
+    virtual ~Transport() = default;
+    virtual int rank() = 0;
+    virtual int size() = 0;
+    virtual void send(int value, int dest, int tag) = 0;
+    virtual void recv(int &value, int &source, int &tag) = 0;
+    virtual bool probe() = 0;
+    virtual void barrier() = 0;
+};
+
+/*
+ * Transport preko MPI-a - jedan proces po filozofu (MPI mora biti inicijaliziran)
+ */
+class MpiTransport : public Transport {
+private:
+    int myRank, numProcs;
+
+public:
+    MpiTransport() {
+        MPI_Comm_rank(MPI_COMM_WORLD, &myRank);
+        MPI_Comm_size(MPI_COMM_WORLD, &numProcs);
+    }
+
+    int rank() override {
+        return myRank;
+    }
+
+    int size() override {
+        return numProcs;
+    }
+
+    void send(int value, int dest, int tag) override {
+        MPI_Send(&value, 1, MPI_INT, dest, tag, MPI_COMM_WORLD);
+    }
+
+    void recv(int &value, int &source, int &tag) override {
+        MPI_Status mpiStatus;
+        MPI_Recv(&value, 1, MPI_INT, MPI_ANY_SOURCE, MPI_ANY_TAG, MPI_COMM_WORLD, &mpiStatus);
+        source = mpiStatus.MPI_SOURCE;
+        tag = mpiStatus.MPI_TAG;
+    }
+
+    bool probe() override {
+        int flag;
+        MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, MPI_COMM_WORLD, &flag, MPI_STATUS_IGNORE);
+        return flag;
+    }
+
+    void barrier() override {
+        MPI_Barrier(MPI_COMM_WORLD);
+    }
+};
+
+/*
+ * Postanski sanducic jednog filozofa - lock-free MPSC red (Vyukov)
+ * Vise filozofa istovremeno dodaje poruke (push) bez zakljucavanja, a cita samo vlasnik (pop).
+ * Mutex i uvjetna varijabla koriste se samo kad vlasnik spava u blokirajucem primanju.
+ */
+class Mailbox {
+private:
+    struct Node {
+        std::atomic<Node *> next;
+        int value, source, tag;
+    };
+
+    alignas(64) std::atomic<Node *> head;       // zadnji dodani cvor (pisu posiljatelji)
+    alignas(64) Node *tail;                     // cvor ispred prve poruke (cita samo vlasnik)
+    std::atomic<bool> sleeping;
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+
+public:
+    Mailbox() {
+        tail = new Node();
+        tail->next.store(nullptr, std::memory_order_relaxed);
+        head.store(tail, std::memory_order_relaxed);
+        sleeping.store(false, std::memory_order_relaxed);
+    }
+
+    ~Mailbox() {
+        while (tail != nullptr) {
+            Node *next = tail->next.load(std::memory_order_relaxed);
+            delete tail;
+            tail = next;
+        }
+    }
+
+    Mailbox(const Mailbox &) = delete;
+    Mailbox &operator=(const Mailbox &) = delete;
+
+    void push(int value, int source, int tag) {
+        Node *node = new Node();
+        node->next.store(nullptr, std::memory_order_relaxed);
+        node->value = value;
+        node->source = source;
+        node->tag = tag;
+
+        Node *prev = head.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleeping.load(std::memory_order_relaxed)) {     // Probudi vlasnika ako ceka
+            std::lock_guard<std::mutex> lock(mutex);
+            wakeUp.notify_one();
+        }
+    }
+
+    bool empty() {
+        return tail->next.load(std::memory_order_acquire) == nullptr;
+    }
+
+    bool pop(int &value, int &source, int &tag) {
+        Node *next = tail->next.load(std::memory_order_acquire);
+        if (next == nullptr) {
+            return false;
+        }
+        value = next->value;
+        source = next->source;
+        tag = next->tag;
+        delete tail;
+        tail = next;
+        return true;
+    }
+
+    void waitPop(int &value, int &source, int &tag) {
+        for (int spin = 0; spin < 100; spin++) {
+            if (pop(value, source, tag)) {
+                return;
+            }
+        }
+        sleeping.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (empty()) {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeUp.wait(lock, [this] { return !empty(); });
+        }
+        sleeping.store(false, std::memory_order_relaxed);
+        pop(value, source, tag);
+    }
+};
+
+/*
+ * Zajednicko stanje svih filozofa unutar jednog procesa - po jedan sanducic za svakog filozofa i barijera
+ */
+class ThreadNetwork {
+private:
+    std::vector<Mailbox> mailboxes;
+    std::mutex barrierMutex;
+    std::condition_variable barrierDone;
+    int barrierCount, barrierGeneration;
+
+public:
+    explicit ThreadNetwork(int numPhilosophers) : mailboxes(numPhilosophers) {
+        barrierCount = 0;
+        barrierGeneration = 0;
+    }
+
+    int size() {
+        return (int) mailboxes.size();
+    }
+
+    Mailbox &mailbox(int rank) {
+        return mailboxes[rank];
+    }
+
+    void barrier() {
+        std::unique_lock<std::mutex> lock(barrierMutex);
+        int generation = barrierGeneration;
+        if (++barrierCount == size()) {
+            barrierCount = 0;
+            barrierGeneration++;
+            barrierDone.notify_all();
+        } else {
+            barrierDone.wait(lock, [&] { return generation != barrierGeneration; });
+        }
+    }
+};
+
+/*
+ * Transport unutar procesa - svaki filozof je jedna dretva, poruke idu kroz ThreadNetwork
+ */
+class ThreadTransport : public Transport {
+private:
+    ThreadNetwork &network;
+    int myRank;
+
+public:
+    ThreadTransport(ThreadNetwork &network, int rank) : network(network), myRank(rank) {}
+
+    int rank() override {
+        return myRank;
+    }
+
+    int size() override {
+        return network.size();
+    }
+
+    void send(int value, int dest, int tag) override {
+        network.mailbox(dest).push(value, myRank, tag);
+    }
+
+    void recv(int &value, int &source, int &tag) override {
+        network.mailbox(myRank).waitPop(value, source, tag);
+    }
+
+    bool probe() override {
+        return !network.mailbox(myRank).empty();
+    }
+
+    void barrier() override {
+        network.barrier();
+    }
+};
+
+/*
+ * Pokrece body(rank) za svakog od numPhilosophers filozofa u zasebnoj dretvi s malim stogom
+ * (zadanih 8 MB po dretvi onemogucuje desetke tisuca filozofa) i ceka da sve zavrse
+ */
+template<typename Body>
+void runThreads(int numPhilosophers, Body body) {
+    struct Task {
+        Body *body;
+        int rank;
+    };
+    std::vector<Task> tasks(numPhilosophers);
+    std::vector<pthread_t> threads(numPhilosophers);
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr, 256 * 1024);
+
+    for (int i = 0; i < numPhilosophers; i++) {
+        tasks[i] = {&body, i};
+        int error = pthread_create(&threads[i], &attr, [](void *arg) -> void * {
+            Task *task = (Task *) arg;
+            (*task->body)(task->rank);
+            return nullptr;
+        }, &tasks[i]);
+        if (error) {
+            fprintf(stderr, "Neuspjelo stvaranje dretve %d: %s\n", i, strerror(error));
+            exit(1);
+        }
+    }
+    pthread_attr_destroy(&attr);
+
+    for (auto &thread : threads) {
+        pthread_join(thread, nullptr);
+    }
+}
+
+#endif